@@ -0,0 +1,335 @@
+#ifndef QRYPTSECURITY_ASYNC_LOGGING_H
+#define QRYPTSECURITY_ASYNC_LOGGING_H
+
+#include "qryptsecurity_logging.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace QryptSecurity
+{
+namespace logging
+{
+    ///<summary>Describes what AsyncLogWriter does when its queue is full</summary>
+    enum class AsyncLogOverflowPolicy {
+        /// <summary>
+        /// Discard the message and count it in getDroppedCount
+        /// </summary>
+        QRYPTLIB_ASYNC_LOG_DROP,
+
+        /// <summary>
+        /// Wait on the calling thread until the background thread frees a slot
+        /// </summary>
+        QRYPTLIB_ASYNC_LOG_BLOCK
+    };
+
+    ///<summary>
+    /// ILogWriter that queues messages in a lock-free ring buffer and writes them
+    /// to another ILogWriter from a background thread.
+    ///
+    /// Logging threads do not touch the disk and normally take no lock. When the
+    /// background thread is idle, the first message after it goes to sleep takes
+    /// the lock once to wake it; further messages rely on its 10 ms poll.
+    ///
+    /// Rolling file logging and ILogMessageReceiver callbacks are forwarded to the
+    /// wrapped writer and run on the background thread. Anything the wrapped writer
+    /// captures when it writes a record, such as the [%TimeStamp%] and ThreadID of
+    /// the default file log, therefore reflects the background thread and the time
+    /// of writing rather than the logging thread and the time of the event, and
+    /// lags behind while messages are queued.
+    ///
+    /// Example: setLogWriter(std::make_shared<AsyncLogWriter>(getLogWriter(), LogLevel::QRYPTLIB_LOG_LEVEL_INFO))
+    ///</summary>
+    class AsyncLogWriter : public ILogWriter {
+    public:
+        #define ASYNC_LOG_CAPACITY_DEFAULT 8192
+
+        /// <summary>
+        /// Constructs AsyncLogWriter and starts its background thread.
+        /// </summary>
+        /// <param name="logWriter">The ILogWriter messages are written to.</param>
+        /// <param name="logLevel">The level to log at; also set on logWriter.</param>
+        /// <param name="capacity">Number of queued messages, rounded up to a power of two.</param>
+        /// <param name="policy">What to do when the queue is full.</param>
+        AsyncLogWriter(std::shared_ptr<ILogWriter> logWriter,
+                       LogLevel logLevel,
+                       size_t capacity = ASYNC_LOG_CAPACITY_DEFAULT,
+                       AsyncLogOverflowPolicy policy = AsyncLogOverflowPolicy::QRYPTLIB_ASYNC_LOG_DROP)
+            : _Ring(std::make_shared<Ring>(std::move(logWriter), capacity, policy)),
+              _LogLevel(logLevel)
+        {
+            _Ring->logWriter->setLogLevel(logLevel);
+            std::shared_ptr<Ring> ring = _Ring;
+            _Thread = std::thread([ring] { ring->run(); });
+        }
+
+        /// <summary>
+        /// Writes every queued message and stops the background thread.
+        ///
+        /// When the last reference is released on the background thread, e.g. by an
+        /// ILogMessageReceiver that replaces the writer, the thread cannot be joined;
+        /// it is detached instead and finishes writing the queue on its own.
+        /// </summary>
+        ~AsyncLogWriter() override
+        {
+            _Ring->stopping.store(true);
+            _Ring->wake();
+            if (_Ring->onDrainThread()) {
+                _Thread.detach();
+            } else {
+                _Thread.join();
+            }
+        }
+
+        AsyncLogWriter(const AsyncLogWriter&) = delete;
+        AsyncLogWriter& operator=(const AsyncLogWriter&) = delete;
+
+        /// <summary>
+        /// Queues the message at the desired LogLevel.
+        ///
+        /// Messages logged on the background thread, e.g. by an ILogMessageReceiver or
+        /// the wrapped writer, never wait for space: they are dropped when the queue is
+        /// full, whatever the policy, because that thread is the one freeing slots.
+        /// </summary>
+        void logMessage(const std::string& message, LogLevel logLevel) override
+        {
+            if (logLevel < _LogLevel.load(std::memory_order_relaxed)) {
+                return;
+            }
+            _Ring->push(message, logLevel);
+        }
+
+        void registerCallback(ILogMessageReceiver *receiver) override { _Ring->logWriter->registerCallback(receiver); }
+
+        void unregisterCallback() override { _Ring->logWriter->unregisterCallback(); }
+
+        void enableFileLogging(std::string filePath = "qryptlib.log", uint32_t maxFileSizeInBytes = MAX_FILE_SIZE_DEFAULT) override
+        {
+            _Ring->logWriter->enableFileLogging(filePath, maxFileSizeInBytes);
+        }
+
+        void disableFileLogging() override { _Ring->logWriter->disableFileLogging(); }
+
+        void setLogLevel(LogLevel logLevel) override
+        {
+            _LogLevel.store(logLevel, std::memory_order_relaxed);
+            _Ring->logWriter->setLogLevel(logLevel);
+        }
+
+        /// <summary>
+        /// Blocks until every message queued before the call has been written.
+        ///
+        /// Called on the background thread, e.g. from an ILogMessageReceiver, it
+        /// returns immediately, since waiting there would never finish.
+        /// </summary>
+        void flush()
+        {
+            if (!_Ring->onDrainThread()) {
+                _Ring->flush();
+            }
+        }
+
+        /// <summary>
+        /// Returns the number of messages discarded because the queue was full.
+        /// </summary>
+        uint64_t getDroppedCount() const { return _Ring->dropped.load(std::memory_order_relaxed); }
+
+    private:
+        struct Cell {
+            std::atomic<size_t> sequence;
+            std::string message;
+            LogLevel logLevel;
+        };
+
+        // Queue state shared with the background thread, so the thread can keep
+        // draining after a detach in ~AsyncLogWriter.
+        struct Ring {
+            Ring(std::shared_ptr<ILogWriter> writer, size_t capacity, AsyncLogOverflowPolicy overflowPolicy)
+                : logWriter(std::move(writer)),
+                  cells(roundUpCapacity(capacity)),
+                  mask(cells.size() - 1),
+                  policy(overflowPolicy)
+            {
+                for (size_t i = 0; i < cells.size(); i++) {
+                    cells[i].sequence.store(i, std::memory_order_relaxed);
+                }
+            }
+
+            static size_t roundUpCapacity(size_t capacity)
+            {
+                size_t result = 2;
+                while (result < capacity) {
+                    result <<= 1;
+                }
+                return result;
+            }
+
+            bool onDrainThread() const
+            {
+                return drainThreadId.load() == std::this_thread::get_id();
+            }
+
+            void push(const std::string& message, LogLevel logLevel)
+            {
+                while (!tryEnqueue(message, logLevel)) {
+                    if (policy == AsyncLogOverflowPolicy::QRYPTLIB_ASYNC_LOG_DROP || onDrainThread()) {
+                        dropped.fetch_add(1, std::memory_order_relaxed);
+                        return;
+                    }
+                    requestWake();
+                    std::this_thread::yield();
+                }
+                if (sleeping.load()) {
+                    requestWake();
+                }
+            }
+
+            // Bounded multi-producer queue (Vyukov). A cell is free for position pos
+            // when its sequence equals pos and holds a message once it equals pos + 1.
+            bool tryEnqueue(const std::string& message, LogLevel logLevel)
+            {
+                size_t pos = enqueuePos.load(std::memory_order_relaxed);
+                Cell* cell;
+                while (true) {
+                    cell = &cells[pos & mask];
+                    size_t sequence = cell->sequence.load(std::memory_order_acquire);
+                    intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+                    if (diff == 0) {
+                        if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                            break;
+                        }
+                    } else if (diff < 0) {
+                        return false;
+                    } else {
+                        pos = enqueuePos.load(std::memory_order_relaxed);
+                    }
+                }
+                // assign() reuses the cell's buffer, so steady-state logging does not allocate
+                cell->message.assign(message);
+                cell->logLevel = logLevel;
+                // Sequentially consistent so it orders against the sleeping check in
+                // push and the background thread never sleeps on a queued message
+                cell->sequence.store(pos + 1);
+                return true;
+            }
+
+            bool hasQueuedMessage() const
+            {
+                size_t pos = dequeuePos.load(std::memory_order_relaxed);
+                return cells[pos & mask].sequence.load() == pos + 1;
+            }
+
+            size_t drain()
+            {
+                size_t written = 0;
+                size_t pos = dequeuePos.load(std::memory_order_relaxed);
+                while (true) {
+                    Cell& cell = cells[pos & mask];
+                    if (cell.sequence.load(std::memory_order_acquire) != pos + 1) {
+                        break;
+                    }
+                    try {
+                        logWriter->logMessage(cell.message, cell.logLevel);
+                    } catch (...) {
+                        // A failing writer must not stop the background thread
+                    }
+                    cell.sequence.store(pos + mask + 1, std::memory_order_release);
+                    dequeuePos.store(++pos);
+                    written++;
+                }
+                return written;
+            }
+
+            // Only the first caller per sleep takes the lock; run clears the flag on waking
+            void requestWake()
+            {
+                if (!wakePending.exchange(true)) {
+                    wake();
+                }
+            }
+
+            void wake()
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                wakeCondition.notify_one();
+            }
+
+            void flush()
+            {
+                size_t target = enqueuePos.load();
+                std::unique_lock<std::mutex> lock(mutex);
+                flushWaiters.fetch_add(1);
+                wakeCondition.notify_one();
+                while (dequeuePos.load() < target) {
+                    flushedCondition.wait_for(lock, std::chrono::milliseconds(10));
+                }
+                flushWaiters.fetch_sub(1);
+            }
+
+            void run()
+            {
+                drainThreadId.store(std::this_thread::get_id());
+                while (true) {
+                    if (drain() > 0) {
+                        if (flushWaiters.load() > 0) {
+                            std::lock_guard<std::mutex> lock(mutex);
+                            flushedCondition.notify_all();
+                        }
+                        continue;
+                    }
+                    if (stopping.load()) {
+                        break;
+                    }
+                    std::unique_lock<std::mutex> lock(mutex);
+                    sleeping.store(true);
+                    if (!hasQueuedMessage() && !stopping.load() && flushWaiters.load() == 0) {
+                        wakeCondition.wait_for(lock, std::chrono::milliseconds(10));
+                    }
+                    sleeping.store(false);
+                    wakePending.store(false);
+                }
+                // Messages claimed before the stop request may still be being published
+                while (dequeuePos.load() != enqueuePos.load()) {
+                    if (drain() == 0) {
+                        std::this_thread::yield();
+                    }
+                }
+                std::lock_guard<std::mutex> lock(mutex);
+                flushedCondition.notify_all();
+            }
+
+            std::shared_ptr<ILogWriter> logWriter;
+            std::vector<Cell> cells;
+            const size_t mask;
+            const AsyncLogOverflowPolicy policy;
+
+            // Producer and consumer positions on separate cache lines
+            alignas(64) std::atomic<size_t> enqueuePos{0};
+            alignas(64) std::atomic<size_t> dequeuePos{0};
+            alignas(64) std::atomic<uint64_t> dropped{0};
+            std::atomic<int> flushWaiters{0};
+            std::atomic<bool> sleeping{false};
+            std::atomic<bool> wakePending{false};
+            std::atomic<bool> stopping{false};
+            std::atomic<std::thread::id> drainThreadId{std::thread::id()};
+
+            std::mutex mutex;
+            std::condition_variable wakeCondition;
+            std::condition_variable flushedCondition;
+        };
+
+        std::shared_ptr<Ring> _Ring;
+        // Kept here rather than read from logWriter, as ILogWriter has no level getter
+        std::atomic<LogLevel> _LogLevel;
+        std::thread _Thread;
+    };
+
+}
+}
+#endif
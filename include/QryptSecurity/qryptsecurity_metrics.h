@@ -0,0 +1,235 @@
+#ifndef QRYPTSECURITY_METRICS_H
+#define QRYPTSECURITY_METRICS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace QryptSecurity
+{
+namespace metrics
+{
+    ///<summary>
+    /// QryptLib calls an application can record latency for.
+    ///
+    /// QryptLib 0.6.4 does not record metrics itself; applications time their own
+    /// calls with ScopedLatency and fill in a MetricsSnapshot.
+    ///</summary>
+    enum class Metric {
+        METRIC_GEN_SYMMETRIC_KEY,
+        METRIC_GEN_INIT,
+        METRIC_GEN_SYNC,
+        NUM_METRICS
+    };
+
+    static const char* MetricNames[] = {
+        "gen_symmetric_key", "gen_init", "gen_sync"
+    };
+
+    ///<summary>Get the text name of a Metric value</summary>
+    /// <param name="metric">The Metric to get the text name for.</param>
+    inline const char* getMetricText(Metric metric)
+    {
+        return MetricNames[static_cast<int>(metric)];
+    }
+
+    ///<summary>Point-in-time copy of a LatencyHistogram</summary>
+    struct HistogramSnapshot {
+        uint64_t count = 0;
+        uint64_t errors = 0;
+        uint64_t sumNanos = 0;
+        uint64_t maxNanos = 0;
+
+        /// <summary>
+        /// Observation count per bucket, indexed as in LatencyHistogram
+        /// </summary>
+        std::vector<uint64_t> buckets;
+    };
+
+    ///<summary>Point-in-time copy of every metric</summary>
+    struct MetricsSnapshot {
+        /// <summary>
+        /// Latency per Metric, indexed by static_cast<int>(metric)
+        /// </summary>
+        HistogramSnapshot latency[static_cast<int>(Metric::NUM_METRICS)];
+    };
+
+    ///<summary>
+    /// Lock-free latency histogram with logarithmic buckets.
+    ///
+    /// Every power of two is split into four linear sub-buckets, which keeps the
+    /// relative error below 25% from nanoseconds up to the full uint64_t range.
+    ///</summary>
+    class LatencyHistogram {
+    public:
+        static const int SUB_BUCKET_BITS = 2;
+        static const int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+        static const int NUM_BUCKETS = (64 - SUB_BUCKET_BITS) * SUB_BUCKETS + SUB_BUCKETS;
+
+        LatencyHistogram() { reset(); }
+
+        LatencyHistogram(const LatencyHistogram&) = delete;
+        LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+        ///<summary>Get the bucket a value in nanoseconds is counted in</summary>
+        static int bucketIndex(uint64_t nanos)
+        {
+            if (nanos < SUB_BUCKETS) {
+                return static_cast<int>(nanos);
+            }
+            int msb = 63 - __builtin_clzll(nanos);
+            int sub = static_cast<int>((nanos >> (msb - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1));
+            return (msb - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + sub;
+        }
+
+        ///<summary>Get the largest value in nanoseconds counted in a bucket</summary>
+        static uint64_t bucketUpperBound(int index)
+        {
+            if (index < SUB_BUCKETS) {
+                return static_cast<uint64_t>(index);
+            }
+            int shift = index / SUB_BUCKETS - 1;
+            uint64_t sub = static_cast<uint64_t>(index % SUB_BUCKETS);
+            uint64_t lower = (SUB_BUCKETS + sub) << shift;
+            return lower + ((uint64_t(1) << shift) - 1);
+        }
+
+        ///<summary>Record one observation</summary>
+        /// <param name="nanos">The latency in nanoseconds.</param>
+        /// <param name="failed">Whether the operation failed.</param>
+        void record(uint64_t nanos, bool failed = false)
+        {
+            _Buckets[bucketIndex(nanos)].fetch_add(1, std::memory_order_relaxed);
+            _Count.fetch_add(1, std::memory_order_relaxed);
+            _SumNanos.fetch_add(nanos, std::memory_order_relaxed);
+            if (failed) {
+                _Errors.fetch_add(1, std::memory_order_relaxed);
+            }
+            uint64_t max = _MaxNanos.load(std::memory_order_relaxed);
+            while (nanos > max && !_MaxNanos.compare_exchange_weak(max, nanos, std::memory_order_relaxed)) {
+            }
+        }
+
+        ///<summary>Copy the current state</summary>
+        HistogramSnapshot snapshot() const
+        {
+            HistogramSnapshot result;
+            result.buckets.resize(NUM_BUCKETS);
+            for (int i = 0; i < NUM_BUCKETS; i++) {
+                result.buckets[i] = _Buckets[i].load(std::memory_order_relaxed);
+            }
+            result.count = _Count.load(std::memory_order_relaxed);
+            result.errors = _Errors.load(std::memory_order_relaxed);
+            result.sumNanos = _SumNanos.load(std::memory_order_relaxed);
+            result.maxNanos = _MaxNanos.load(std::memory_order_relaxed);
+            return result;
+        }
+
+        ///<summary>Clear all observations</summary>
+        void reset()
+        {
+            for (int i = 0; i < NUM_BUCKETS; i++) {
+                _Buckets[i].store(0, std::memory_order_relaxed);
+            }
+            _Count.store(0, std::memory_order_relaxed);
+            _Errors.store(0, std::memory_order_relaxed);
+            _SumNanos.store(0, std::memory_order_relaxed);
+            _MaxNanos.store(0, std::memory_order_relaxed);
+        }
+
+    private:
+        std::atomic<uint64_t> _Buckets[NUM_BUCKETS];
+        std::atomic<uint64_t> _Count;
+        std::atomic<uint64_t> _Errors;
+        std::atomic<uint64_t> _SumNanos;
+        std::atomic<uint64_t> _MaxNanos;
+    };
+
+    ///<summary>
+    /// Records the lifetime of the object into a LatencyHistogram.
+    ///
+    /// Pass nullptr to skip recording, e.g. when metrics are disabled.
+    ///</summary>
+    class ScopedLatency {
+    public:
+        explicit ScopedLatency(LatencyHistogram* histogram)
+            : _Histogram(histogram)
+        {
+            if (_Histogram) {
+                _Start = std::chrono::steady_clock::now();
+            }
+        }
+
+        ~ScopedLatency()
+        {
+            if (_Histogram) {
+                auto elapsed = std::chrono::steady_clock::now() - _Start;
+                _Histogram->record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()), _Failed);
+            }
+        }
+
+        ScopedLatency(const ScopedLatency&) = delete;
+        ScopedLatency& operator=(const ScopedLatency&) = delete;
+
+        ///<summary>Count the observation as an error</summary>
+        void fail() { _Failed = true; }
+
+    private:
+        LatencyHistogram* _Histogram;
+        std::chrono::steady_clock::time_point _Start;
+        bool _Failed = false;
+    };
+
+    ///<summary>
+    /// Format a snapshot in the Prometheus text exposition format.
+    ///
+    /// Every histogram reports the same fixed bucket bounds, one per power of two
+    /// from about 1 microsecond to about 137 seconds, so series stay stable between
+    /// scrapes.
+    ///</summary>
+    /// <param name="snapshot">The snapshot to format.</param>
+    /// <param name="prefix">Prefix prepended to every metric name.</param>
+    #define PROMETHEUS_MIN_BOUND_BITS 10   // 2^10 ns, about 1 microsecond
+    #define PROMETHEUS_MAX_BOUND_BITS 37   // 2^37 ns, about 137 seconds
+    inline std::string formatPrometheus(const MetricsSnapshot& snapshot, const std::string& prefix = "qryptlib_")
+    {
+        std::ostringstream out;
+        out.precision(std::numeric_limits<double>::max_digits10);
+        for (int m = 0; m < static_cast<int>(Metric::NUM_METRICS); m++) {
+            std::string name = prefix + MetricNames[m];
+            const HistogramSnapshot& latency = snapshot.latency[m];
+
+            // Buckets are summed rather than using count so +Inf and _count stay
+            // consistent with the buckets while observations race the snapshot.
+            out << "# TYPE " << name << "_seconds histogram\n";
+            uint64_t cumulative = 0;
+            for (int i = 0; i < LatencyHistogram::NUM_BUCKETS; i++) {
+                if (static_cast<size_t>(i) < latency.buckets.size()) {
+                    cumulative += latency.buckets[i];
+                }
+                // Report only the last sub-bucket of each power of two in range
+                int bits = i / LatencyHistogram::SUB_BUCKETS + LatencyHistogram::SUB_BUCKET_BITS;
+                if (i % LatencyHistogram::SUB_BUCKETS != LatencyHistogram::SUB_BUCKETS - 1 ||
+                    bits < PROMETHEUS_MIN_BOUND_BITS || bits > PROMETHEUS_MAX_BOUND_BITS) {
+                    continue;
+                }
+                out << name << "_seconds_bucket{le=\""
+                    << LatencyHistogram::bucketUpperBound(i) / 1e9 << "\"} " << cumulative << "\n";
+            }
+            out << name << "_seconds_bucket{le=\"+Inf\"} " << cumulative << "\n";
+            out << name << "_seconds_sum " << latency.sumNanos / 1e9 << "\n";
+            out << name << "_seconds_count " << cumulative << "\n";
+
+            out << "# TYPE " << name << "_errors_total counter\n";
+            out << name << "_errors_total " << latency.errors << "\n";
+        }
+        return out.str();
+    }
+
+}
+}
+#endif